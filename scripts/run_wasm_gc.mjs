@@ -0,0 +1,57 @@
+// Run a MoonBit wasm-gc main module that links against the DuckDB host imports.
+//
+//   node scripts/run_wasm_gc.mjs <module.wasm>
+//
+// The module must be built with `use-js-builtin-string`, so this needs a Node
+// release with wasm GC and JS string builtins (Node 24+, or Node 22 with
+// --experimental-wasm-imported-strings).
+import { readFile } from "node:fs/promises";
+import { createDuckDBHost } from "./wasm_gc_host.mjs";
+
+const path = process.argv[2];
+if (!path) {
+  console.error("usage: node scripts/run_wasm_gc.mjs <module.wasm>");
+  process.exit(2);
+}
+
+const module = await WebAssembly.compile(await readFile(path), {
+  builtins: ["js-string"],
+  importedStringConstants: "_",
+});
+
+let line = "";
+const imports = {
+  duckdb: createDuckDBHost(),
+  "moonbit:ffi": {
+    make_closure: (func, closure) => func.bind(null, closure),
+  },
+  spectest: {
+    print_char: (code) => {
+      if (code === 10) {
+        console.log(line);
+        line = "";
+      } else {
+        line += String.fromCharCode(code);
+      }
+    },
+  },
+  console: {
+    log: (value) => console.log(value),
+  },
+};
+
+const provided = new Set(["_", "wasm:js-string"]);
+const missing = WebAssembly.Module.imports(module).filter(
+  ({ module: from, name }) =>
+    !provided.has(from) && !(imports[from] && name in imports[from]),
+);
+if (missing.length > 0) {
+  const names = missing.map(({ module: from, name }) => `${from}.${name}`);
+  console.error(`unresolved imports: ${names.join(", ")}`);
+  process.exit(1);
+}
+
+const instance = await WebAssembly.instantiate(module, imports);
+if (typeof instance.exports._start === "function") {
+  instance.exports._start();
+}
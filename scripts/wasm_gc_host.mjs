@@ -0,0 +1,500 @@
+// Host imports for the MoonBit wasm-gc target (module "duckdb").
+//
+// The wasm module only sees opaque handles: connections, statements, streams
+// and batches are plain JS objects. Each chunk is converted to a columnar
+// batch, and each column crosses the boundary once per batch: fixed-width
+// values and the validity bitmap as the 16-bit words of their little-endian
+// bytes, packed into a JS string, and text columns as one concatenated string
+// plus packed end offsets. The MoonBit side reads the words back with
+// charCodeAt (a js-string builtin, so no call into JS) and formats the cells
+// itself.
+
+const KIND_STRING = 0;
+const KIND_INT32 = 1;
+const KIND_INT64 = 2;
+const KIND_DOUBLE = 3;
+const KIND_BOOL = 4;
+const KIND_FLOAT = 5;
+
+// Arrow JS `Type` enum values used by duckdb-wasm record batches.
+const ARROW_INT = 2;
+const ARROW_FLOAT = 3;
+const ARROW_UTF8 = 5;
+const ARROW_BOOL = 6;
+
+const toError = (err) => (err && err.message ? err.message : String(err));
+
+// Settle a host promise with the wasm callbacks. They run from a fresh
+// microtask, outside the promise chain, so an exception thrown by `on_ok`
+// surfaces as uncaught instead of being reported again through `on_err`.
+const dispatch = (promise, on_ok, on_err) => {
+  promise.then(
+    (value) => queueMicrotask(() => on_ok(value)),
+    (err) => queueMicrotask(() => on_err(toError(err))),
+  );
+};
+
+const toText = (value) => {
+  if (typeof value === "string") {
+    return value;
+  }
+  if (typeof value === "number") {
+    if (Number.isNaN(value)) return "nan";
+    if (value === Infinity) return "inf";
+    if (value === -Infinity) return "-inf";
+    return String(value);
+  }
+  if (typeof value === "object" && !Array.isArray(value) &&
+      value.toString !== Object.prototype.toString) {
+    return value.toString();
+  }
+  if (typeof value === "boolean" || typeof value === "bigint") {
+    return String(value);
+  }
+  return JSON.stringify(value);
+};
+
+// Pack the bytes of a typed array (or a byte array of even length) into a
+// string of 16-bit code units.
+const packWords = (typed) => {
+  const words = new Uint16Array(typed.buffer, typed.byteOffset,
+    typed.byteLength >> 1);
+  const step = 8192;
+  let out = "";
+  for (let i = 0; i < words.length; i += step) {
+    out += String.fromCharCode.apply(null, words.subarray(i, i + step));
+  }
+  return out;
+};
+
+// Column buffers for `rowCount` values of `kind`. The validity bitmap is
+// padded to whole 16-bit words; a set bit marks a non-NULL row.
+const newColumn = (kind, rowCount) => {
+  let values;
+  switch (kind) {
+    case KIND_INT32:
+    case KIND_BOOL:
+      values = new Int32Array(rowCount);
+      break;
+    case KIND_INT64:
+      values = new BigInt64Array(rowCount);
+      break;
+    case KIND_DOUBLE:
+    case KIND_FLOAT:
+      values = new Float64Array(rowCount);
+      break;
+    default:
+      values = new Array(rowCount).fill("");
+  }
+  return {
+    kind,
+    values,
+    valid: new Uint8Array(((rowCount + 15) >> 4) << 1),
+    nulls: 0,
+  };
+};
+
+const finishColumn = (column) => {
+  const valid = column.nulls === 0 ? "" : packWords(column.valid);
+  if (column.kind !== KIND_STRING) {
+    return { kind: column.kind, words: packWords(column.values), valid };
+  }
+  const ends = new Int32Array(column.values.length);
+  let length = 0;
+  for (let r = 0; r < ends.length; r++) {
+    length += column.values[r].length;
+    ends[r] = length;
+  }
+  return {
+    kind: column.kind,
+    words: packWords(ends),
+    text: column.values.join(""),
+    valid,
+  };
+};
+
+// Fill a column from per-row JS values, for client libraries that only hand
+// out materialized values.
+const packValues = (kind, rowCount, get) => {
+  const column = newColumn(kind, rowCount);
+  const { values, valid } = column;
+  for (let r = 0; r < rowCount; r++) {
+    const value = get(r);
+    if (value === null || value === undefined) {
+      column.nulls++;
+      continue;
+    }
+    valid[r >> 3] |= 1 << (r & 7);
+    switch (kind) {
+      case KIND_INT64:
+        values[r] = BigInt(value);
+        break;
+      case KIND_BOOL:
+        values[r] = value ? 1 : 0;
+        break;
+      case KIND_STRING:
+        values[r] = toText(value);
+        break;
+      default:
+        values[r] = Number(value);
+    }
+  }
+  return finishColumn(column);
+};
+
+// ----------------------------------------------------------------------------
+// @duckdb/node-api
+// ----------------------------------------------------------------------------
+
+let nodeApi = null;
+
+const loadNodeApi = async () => {
+  if (!nodeApi) {
+    nodeApi = await import("@duckdb/node-api");
+  }
+  return nodeApi;
+};
+
+const nodeKind = (typeId) => {
+  const t = nodeApi.DuckDBTypeId;
+  switch (typeId) {
+    case t.BOOLEAN:
+      return KIND_BOOL;
+    case t.TINYINT:
+    case t.SMALLINT:
+    case t.INTEGER:
+    case t.UTINYINT:
+    case t.USMALLINT:
+      return KIND_INT32;
+    case t.BIGINT:
+    case t.UINTEGER:
+      return KIND_INT64;
+    case t.FLOAT:
+      return KIND_FLOAT;
+    case t.DOUBLE:
+      return KIND_DOUBLE;
+    default:
+      return KIND_STRING;
+  }
+};
+
+const nodeStream = (result) => {
+  const columns = result.columnNames();
+  const typeIds = columns.map((_, idx) => result.columnTypeId(idx));
+  return {
+    kind: "node",
+    result,
+    columns,
+    typeIds,
+    kinds: typeIds.map(nodeKind),
+    done: false,
+  };
+};
+
+const nodeNext = async (stream) => {
+  const chunk = await stream.result.fetchChunk();
+  if (!chunk || chunk.rowCount <= 0) {
+    return null;
+  }
+  const rowCount = chunk.rowCount;
+  const columns = chunk.getColumns();
+  return {
+    rowCount,
+    columns: columns.map((values, c) =>
+      packValues(stream.kinds[c], rowCount, (r) => values[r])
+    ),
+  };
+};
+
+// ----------------------------------------------------------------------------
+// @duckdb/duckdb-wasm
+// ----------------------------------------------------------------------------
+
+const arrowKind = (type) => {
+  if (!type) {
+    return KIND_STRING;
+  }
+  if (type.typeId === ARROW_BOOL) {
+    return KIND_BOOL;
+  }
+  if (type.typeId === ARROW_INT) {
+    if (type.bitWidth < 32 || (type.bitWidth === 32 && type.isSigned)) {
+      return KIND_INT32;
+    }
+    if (type.bitWidth === 32 || type.isSigned) {
+      return KIND_INT64;
+    }
+    return KIND_STRING;
+  }
+  if (type.typeId === ARROW_FLOAT) {
+    if (type.precision === 2) return KIND_DOUBLE;
+    if (type.precision === 1) return KIND_FLOAT;
+  }
+  return KIND_STRING;
+};
+
+const wasmStream = (reader) => {
+  let columns = [];
+  if (reader && reader.schema && reader.schema.fields) {
+    columns = reader.schema.fields.map((field) => field.name);
+  }
+  return {
+    kind: "wasm",
+    reader,
+    columns,
+    typeIds: columns.map(() => -1),
+    done: false,
+  };
+};
+
+// Copy one Arrow vector into column buffers chunk by chunk: value buffers
+// with TypedArray.set, validity and booleans bit by bit. Arrow slices keep
+// bitmaps unsliced, so those are read from `data.offset`.
+const packArrow = (kind, vector, rowCount) => {
+  if (!vector) {
+    return packValues(kind, rowCount, () => null);
+  }
+  const textDecoder = vector.type && vector.type.typeId === ARROW_UTF8
+    ? new TextDecoder()
+    : null;
+  if (kind === KIND_STRING && !textDecoder) {
+    return packValues(kind, rowCount, (r) => vector.get(r));
+  }
+  const column = newColumn(kind, rowCount);
+  const { values, valid } = column;
+  // UINT32 widened to int64: low word is the value, high word stays zero.
+  const widened = kind === KIND_INT64 && vector.type.bitWidth !== 64
+    ? new Uint32Array(values.buffer)
+    : null;
+  let pos = 0;
+  for (const data of vector.data) {
+    const length = Math.min(data.length, rowCount - pos);
+    const bitmap = data.nullCount > 0 ? data.nullBitmap : null;
+    for (let i = 0; i < length; i++) {
+      const bit = data.offset + i;
+      const r = pos + i;
+      if (bitmap && (bitmap[bit >> 3] & (1 << (bit & 7))) === 0) {
+        column.nulls++;
+      } else {
+        valid[r >> 3] |= 1 << (r & 7);
+      }
+    }
+    if (kind === KIND_BOOL) {
+      for (let i = 0; i < length; i++) {
+        const bit = data.offset + i;
+        values[pos + i] = (data.values[bit >> 3] >> (bit & 7)) & 1;
+      }
+    } else if (textDecoder) {
+      const ends = data.valueOffsets;
+      for (let i = 0; i < length; i++) {
+        values[pos + i] = textDecoder.decode(
+          data.values.subarray(ends[i], ends[i + 1]),
+        );
+      }
+    } else if (widened) {
+      for (let i = 0; i < length; i++) {
+        widened[(pos + i) * 2] = data.values[i];
+      }
+    } else {
+      values.set(data.values.subarray(0, length), pos);
+    }
+    pos += length;
+  }
+  return finishColumn(column);
+};
+
+const wasmNext = async (stream) => {
+  if (stream.done) {
+    return null;
+  }
+  const next = await stream.reader.next();
+  if (!next || next.done || !next.value) {
+    stream.done = true;
+    return null;
+  }
+  const batch = next.value;
+  const rowCount = batch.numRows ?? batch.length ?? 0;
+  const fields = batch.schema && batch.schema.fields ? batch.schema.fields : [];
+  if (stream.columns.length === 0 && fields.length > 0) {
+    stream.columns = fields.map((field) => field.name);
+    stream.typeIds = fields.map(() => -1);
+  }
+  const columns = [];
+  for (let c = 0; c < stream.columns.length; c++) {
+    const vector = batch.getChildAt ? batch.getChildAt(c) : batch.getChild(c);
+    const kind = arrowKind(vector ? vector.type : null);
+    columns.push(packArrow(kind, vector, rowCount));
+  }
+  return { rowCount, columns };
+};
+
+const wasmParams = (stmt) =>
+  Object.keys(stmt.params)
+    .map(Number)
+    .sort((a, b) => a - b)
+    .map((index) => stmt.params[index]);
+
+// ----------------------------------------------------------------------------
+// Import object
+// ----------------------------------------------------------------------------
+
+export const createDuckDBHost = () => {
+  const bind = (stmt, index, value, nodeBind) => {
+    try {
+      if (stmt.backend === "node") {
+        nodeBind(stmt.statement, index, value);
+      } else {
+        stmt.params[index] = value;
+      }
+      return "";
+    } catch (err) {
+      return toError(err);
+    }
+  };
+
+  return {
+    connect(path, backend, on_ok, on_err) {
+      const isNode = typeof process !== "undefined" &&
+        !!(process.versions && process.versions.node);
+      const mode = backend === 0 ? (isNode ? 1 : 2) : backend;
+      const run = async () => {
+        if (mode === 1) {
+          const api = await loadNodeApi();
+          const instance = await api.DuckDBInstance.create(path || ":memory:");
+          const connection = await instance.connect();
+          return { kind: "node", instance, connection };
+        }
+        if (mode === 2) {
+          if (typeof Worker === "undefined") {
+            throw new Error("duckdb-wasm requires Worker support");
+          }
+          const duckdb = await import("@duckdb/duckdb-wasm");
+          const bundle = await duckdb.selectBundle(duckdb.getJsDelivrBundles());
+          const worker = new Worker(bundle.mainWorker);
+          const db = new duckdb.AsyncDuckDB(new duckdb.ConsoleLogger(), worker);
+          await db.instantiate(bundle.mainModule, bundle.pthreadWorker);
+          const conn = await db.connect();
+          return { kind: "wasm", db, conn, worker };
+        }
+        throw new Error("unknown JsBackend");
+      };
+      dispatch(run(), on_ok, on_err);
+    },
+
+    close(conn, on_ok, on_err) {
+      const run = async () => {
+        if (conn.kind === "node") {
+          conn.connection.closeSync();
+          if (typeof conn.instance.close === "function") {
+            await conn.instance.close();
+          }
+        } else {
+          await conn.conn.close();
+          await conn.db.terminate();
+          conn.worker.terminate();
+        }
+      };
+      dispatch(run(), () => on_ok(), on_err);
+    },
+
+    stream_open(conn, sql, on_ok, on_err) {
+      const run = async () => {
+        if (conn.kind === "node") {
+          await loadNodeApi();
+          return nodeStream(await conn.connection.stream(sql));
+        }
+        return wasmStream(await conn.conn.send(sql, true));
+      };
+      dispatch(run(), on_ok, on_err);
+    },
+
+    stream_column_count: (stream) => stream.columns.length,
+    stream_column_name: (stream, index) => stream.columns[index],
+    stream_column_type: (stream, index) => stream.typeIds[index] ?? -1,
+
+    stream_next(stream, on_batch, on_end, on_err) {
+      const run = async () =>
+        stream.kind === "node" ? await nodeNext(stream) : await wasmNext(stream);
+      dispatch(
+        run(),
+        (batch) => (batch === null ? on_end() : on_batch(batch)),
+        on_err,
+      );
+    },
+
+    stream_close(stream, on_ok, on_err) {
+      const run = async () => {
+        if (stream.kind === "wasm" && !stream.done &&
+            typeof stream.reader.cancel === "function") {
+          await stream.reader.cancel();
+        }
+        stream.done = true;
+      };
+      dispatch(run(), () => on_ok(), on_err);
+    },
+
+    prepare(conn, sql, on_ok, on_err) {
+      const run = async () => {
+        const statement = conn.kind === "node"
+          ? await conn.connection.prepare(sql)
+          : await conn.conn.prepare(sql);
+        return { backend: conn.kind, statement, params: {} };
+      };
+      dispatch(run(), on_ok, on_err);
+    },
+
+    bind_int: (stmt, index, value) =>
+      bind(stmt, index, value, (s, i, v) => s.bindInteger(i, v)),
+    bind_bigint: (stmt, index, value) =>
+      bind(stmt, index, value, (s, i, v) => s.bindBigInt(i, v)),
+    bind_double: (stmt, index, value) =>
+      bind(stmt, index, value, (s, i, v) => s.bindDouble(i, v)),
+    bind_varchar: (stmt, index, value) =>
+      bind(stmt, index, value, (s, i, v) => s.bindVarchar(i, v)),
+    bind_bool: (stmt, index, value) =>
+      bind(stmt, index, value !== 0, (s, i, v) => s.bindBoolean(i, v)),
+    bind_null: (stmt, index) =>
+      bind(stmt, index, null, (s, i) => s.bindNull(i)),
+
+    clear_bindings(stmt) {
+      try {
+        if (stmt.backend === "node") {
+          stmt.statement.clearBindings();
+        }
+        stmt.params = {};
+        return "";
+      } catch (err) {
+        return toError(err);
+      }
+    },
+
+    statement_stream(stmt, on_ok, on_err) {
+      const run = async () => {
+        if (stmt.backend === "node") {
+          await loadNodeApi();
+          return nodeStream(await stmt.statement.stream());
+        }
+        return wasmStream(await stmt.statement.send(...wasmParams(stmt)));
+      };
+      dispatch(run(), on_ok, on_err);
+    },
+
+    statement_close(stmt, on_ok, on_err) {
+      const run = async () => {
+        if (stmt.backend === "wasm" && typeof stmt.statement.close === "function") {
+          await stmt.statement.close();
+        }
+        stmt.params = {};
+      };
+      dispatch(run(), () => on_ok(), on_err);
+    },
+
+    batch_row_count: (batch) => batch.rowCount,
+    batch_column_kind: (batch, col) => batch.columns[col].kind,
+    batch_column_words: (batch, col) => batch.columns[col].words,
+    batch_column_validity: (batch, col) => batch.columns[col].valid,
+    batch_column_text: (batch, col) => batch.columns[col].text ?? "",
+
+    now_millis: () => performance.now(),
+  };
+};